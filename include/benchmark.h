@@ -0,0 +1,25 @@
+#pragma once
+
+//
+// Name: benchmark.h
+// Purpose: Timing benchmarks, printed to serial. Build with -D LIGHTBOX_BENCHMARK to enable.
+//
+// This program is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2.1 of the License, or any later version.
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+// Do not remove information from this header.
+//
+// Version History:
+// 0.2    2026-10-19    Initial version.
+//
+
+#include <stdint.h>
+
+namespace Benchmark
+{
+  void run();
+  void printMemory(uint16_t bytesPerLED);
+};
@@ -12,11 +12,15 @@
 // PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 // Do not remove information from this header.
 //
+// NOTE: Pallettes 0 to 2 are built-in, further pallettes are user defined and held in
+// EEPROM. Only the active pallette is held in RAM.
+//
 // NOTE: See here for colour names:
 // https://github.com/FastLED/FastLED/wiki/Pixel-reference
 //
 // Version History:
 // 0.1    2025-12-01    Initial version.
+// 0.2    2026-10-19    User defined pallettes, active pallette cache.
 //
 
 #include <stdint.h>
@@ -24,9 +28,13 @@
 
 class Colours {
   public:
+    static const uint8_t numBuiltInPallettes = 3;
+    static const uint8_t maxPalletteSize = 32;
+
     Colours() { setPallette(0); setColour(0); };
 
     const uint8_t getPallette() { return palletteNum_; }
+    const uint8_t getNumPallettes();
     void setPallette(uint8_t palletteNum);
     uint8_t nextPallette();
 
@@ -34,38 +42,21 @@ class Colours {
     void setColour(uint8_t colourNum);
     uint8_t incrementColour();
     uint8_t decrementColour();
-    CRGB getColour() { return pallettes_[palletteNum_][colourNum_]; }
+    CRGB getColour() { return cache_[colourNum_]; }
+    CRGB getColour(uint8_t colourNum) { return cache_[colourNum]; }
+    const uint8_t getPalletteSize() { return cacheSize_; }
     CRGB getPreviousColour() { return previousColour_; };
     CRGB randomColour();
+    uint8_t randomColourNum(uint8_t excludeNum);
 
   private:
-    static const uint8_t numPallettes_ = 3;
-    const uint8_t palletteSizes_[numPallettes_] = { pallette0Size, pallette1Size, pallette2Size };
-    const CRGB* const pallettes_[numPallettes_] = { pallette0_, pallette1_, pallette2_ };
+    void loadPallette();
+
     uint8_t palletteNum_;
     uint8_t colourNum_;
     CRGB previousColour_ = CRGB::Black;
 
-    // Pallette 0: White and primary colours.
-    static const uint8_t pallette0Size = 4;
-    const CRGB pallette0_[pallette0Size] = {
-      CRGB::White, CRGB::Red, CRGB::Green, CRGB::Blue
-    };
-
-    // Pallette 1: pallette 0 plus desaturated primary colours.
-    static const uint8_t pallette1Size = 7;
-    const CRGB pallette1_[pallette1Size] = {
-      CRGB::White, CRGB::Red, CRGB::Green, CRGB::Blue,
-      CRGB::Cyan, CRGB::Magenta, CRGB::Yellow
-    };
-
-    // Pallette 2: pallette 1 plus some others.
-    static const uint8_t pallette2Size = 16;
-    const CRGB pallette2_[pallette2Size] = {
-      CRGB::White, CRGB::Red, CRGB::Green, CRGB::Blue,
-      CRGB::Cyan, CRGB::Magenta, CRGB::Yellow,
-      CRGB::Pink, CRGB::LightGreen, CRGB::LightBlue,
-      CRGB::Maroon, CRGB::YellowGreen, CRGB::Navy,
-      CRGB::Orange, CRGB::Chocolate, CRGB::Indigo
-    };
+    // Cache of the active pallette, loaded from flash (built-in) or EEPROM (user defined).
+    CRGB cache_[maxPalletteSize];
+    uint8_t cacheSize_;
 };
\ No newline at end of file
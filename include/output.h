@@ -0,0 +1,40 @@
+#pragma once
+
+//
+// Name: output.h
+// Purpose: Output stage: gamma, white balance, brightness and temporal dithering.
+//
+// This program is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2.1 of the License, or any later version.
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+// Do not remove information from this header.
+//
+// NOTE: Each colour channel is mapped through a table in flash to a 16-bit linear value,
+// scaled by brightness, then reduced to 8 bits with the remainder dithered over successive
+// calls to show(). FastLED brightness is left at full, as it is applied here.
+//
+// Version History:
+// 0.2    2026-10-19    Initial version.
+//
+
+#include <stdint.h>
+#include <FastLED.h>
+
+namespace Output
+{
+  // Maximum CPU cycles per pixel for update(), checked by the benchmark. Counted by hand from
+  // the AVR instruction timings as 149 per pixel plus 64 per call, which adds 32 per pixel at
+  // the smallest frame of 2 LEDs.
+  constexpr uint16_t cycleBudget = 190;
+
+  void Init(const CRGB* frame, CRGB* leds, uint16_t numLEDs);
+
+  const uint8_t getBrightness();
+  void setBrightness(uint8_t value);
+
+  void update();
+  void show();
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+//
+// Name: scheduler.h
+// Purpose: Min-heap of per-LED deadlines, so only LEDs whose timers expire are updated.
+//
+// This program is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2.1 of the License, or any later version.
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+// Do not remove information from this header.
+//
+// NOTE: Deadlines are the low 16 bits of millis() and are compared with wrap around,
+// so every pending deadline must be less than 32767 ms from the current time.
+//
+// Version History:
+// 0.2    2026-10-19    Initial version.
+//
+
+#include <stdint.h>
+
+class Scheduler {
+  public:
+    struct Event {
+      uint16_t deadline;  // Low 16 bits of millis() when event is due
+      uint16_t id;        // Caller defined, eg LED number
+    };
+
+    // Storage for events is provided by the caller, sized for the maximum pending events.
+    Scheduler(Event* events, uint16_t capacity) : events_(events), capacity_(capacity) {};
+
+    void clear() { size_ = 0; }
+    const bool empty() { return size_ == 0; }
+    const uint16_t size() { return size_; }
+    bool schedule(uint16_t id, uint16_t deadline);
+    bool due(uint16_t now);
+    uint16_t pop();
+
+  private:
+    static bool before(uint16_t a, uint16_t b) { return static_cast<int16_t>(a - b) < 0; }
+
+    Event* const events_;
+    const uint16_t capacity_;
+    uint16_t size_ = 0;
+};
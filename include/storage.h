@@ -14,9 +14,11 @@
 //
 // Version History:
 // 0.1    2025-12-01    Initial version.
+// 0.2    2026-10-19    User defined pallette store.
 //
 
 #include <stdint.h>
+#include <FastLED.h>
 
 namespace Storage
 {
@@ -37,4 +39,14 @@ namespace Storage
 
   const uint8_t getPallette();
   void setPallette(uint8_t value);
+
+  // User defined pallettes, each stored as: size, name, size * RGB.
+  constexpr uint8_t palletteNameLength = 8;
+  constexpr uint8_t maxPallettes = 64;
+  const uint8_t getNumPallettes();
+  const uint16_t getPalletteCapacity();
+  const uint16_t getPalletteUsed();
+  uint8_t readPallette(uint8_t index, char* name, CRGB* colours, uint8_t maxColours);
+  bool writePallette(const char* name, const CRGB* colours, uint8_t size);
+  void clearPallettes();
 };
\ No newline at end of file
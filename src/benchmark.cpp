@@ -0,0 +1,227 @@
+//
+// Name: benchmark.cpp
+// Purpose: Timing benchmarks, printed to serial. Build with -D LIGHTBOX_BENCHMARK to enable.
+//
+// This program is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2.1 of the License, or any later version.
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+// Do not remove information from this header.
+//
+// NOTE: Time is simulated, so each benchmark runs as fast as the code allows.
+//
+// Version History:
+// 0.2    2026-10-19    Initial version.
+//
+
+#ifdef LIGHTBOX_BENCHMARK
+
+#include <Arduino.h>
+#include "benchmark.h"
+#include "colours.h"
+#include "output.h"
+#include "scheduler.h"
+#include "storage.h"
+
+namespace {
+  constexpr uint16_t maxLEDs          = 300;
+  constexpr uint16_t numFrames        = 250;
+  constexpr uint16_t frameInterval    = 20;
+  constexpr uint16_t fadeStepInterval = 20;     // As main: re-arm period of a fading LED
+  constexpr uint8_t eventLEDBits      = 9;      // Event id: LED number, then fade steps left
+  constexpr uint16_t eventLEDMask     = (1 << eventLEDBits) - 1;
+
+  // Benchmarks run one at a time, so share their buffers to fit in SRAM.
+  union Pool {
+    Pool() {}
+    Scheduler::Event events[maxLEDs];
+    struct {
+      uint16_t deadlines[maxLEDs];
+      uint8_t steps[maxLEDs];
+    } scan;
+    CRGB pixels[maxLEDs];
+  } pool;
+
+  Colours colours;
+  uint16_t colourInterval = 1000;   // Default colour interval
+  CRGB fadeColour;                  // Result of each fade step
+
+  // Cheap pseudo random number, so random() does not dominate the timings.
+  uint16_t lfsr = 0xACE1;
+  uint16_t randomLFSR() {
+    lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+    return lfsr;
+  }
+
+  // Hold between 0.5 and 1.5 of the colour interval, as randomHoldInterval() in main.
+  uint16_t randomHold() {
+    return colourInterval / 2 + randomLFSR() % colourInterval;
+  }
+
+  // One Twinkle timeline event, as updateTimeline() in main: at the end of a hold start a fade,
+  // otherwise blend one fade step. Returns the fade steps left, and the delay to the next event.
+  uint8_t timelineEvent(uint8_t steps, uint16_t& delay) {
+    uint8_t fadeSteps = colourInterval / 4 / fadeStepInterval;
+
+    if (steps == 0) {
+      delay = fadeStepInterval;
+      return fadeSteps;
+    }
+    uint8_t fadeFraction = 0xFF - static_cast<uint32_t>(steps) * 0xFF / fadeSteps;
+    fadeColour = colours.getColour(0).lerp8(colours.getColour(1), fadeFraction);
+    steps--;
+    delay = steps ? fadeStepInterval : randomHold();
+    return steps;
+  }
+
+  // Write the per-frame time and events of a timeline benchmark.
+  void printTimelineCost(uint16_t numLEDs, uint32_t numEvents, uint32_t elapsed) {
+    Serial.print(numLEDs);
+    Serial.print(F(", events/frame: "));
+    Serial.print(static_cast<float>(numEvents) / numFrames);
+    Serial.print(F(", us/frame: "));
+    Serial.println(elapsed / numFrames);
+  }
+
+  // Per-frame cost of the Twinkle hold and fade steps, popping only the expired deadlines.
+  void benchScheduler(uint16_t numLEDs) {
+    Scheduler scheduler(pool.events, numLEDs);
+    uint16_t now = 0;
+    uint32_t numEvents = 0;
+
+    lfsr = 0xACE1;
+    for (uint16_t i = 0; i < numLEDs; i++) {
+      scheduler.schedule(i, randomLFSR() % colourInterval);
+    }
+    uint32_t start = micros();
+    for (uint16_t f = 0; f < numFrames; f++) {
+      now += frameInterval;
+      while (scheduler.due(now)) {
+        uint16_t id = scheduler.pop();
+        uint16_t delay;
+        uint8_t steps = timelineEvent(id >> eventLEDBits, delay);
+        scheduler.schedule((id & eventLEDMask) | (steps << eventLEDBits), now + delay);
+        numEvents++;
+      }
+    }
+    uint32_t elapsed = micros() - start;
+
+    Serial.print(F("Scheduler, LEDs: "));
+    printTimelineCost(numLEDs, numEvents, elapsed);
+  }
+
+  // Per-frame cost of the same timelines, checking every LED's deadline, for comparison.
+  void benchScan(uint16_t numLEDs) {
+    uint16_t now = 0;
+    uint32_t numEvents = 0;
+
+    lfsr = 0xACE1;
+    for (uint16_t i = 0; i < numLEDs; i++) {
+      pool.scan.deadlines[i] = randomLFSR() % colourInterval;
+      pool.scan.steps[i] = 0;
+    }
+    uint32_t start = micros();
+    for (uint16_t f = 0; f < numFrames; f++) {
+      now += frameInterval;
+      for (uint16_t i = 0; i < numLEDs; i++) {
+        if (static_cast<int16_t>(now - pool.scan.deadlines[i]) >= 0) {
+          uint16_t delay;
+          pool.scan.steps[i] = timelineEvent(pool.scan.steps[i], delay);
+          pool.scan.deadlines[i] = now + delay;
+          numEvents++;
+        }
+      }
+    }
+    uint32_t elapsed = micros() - start;
+
+    Serial.print(F("Linear scan, LEDs: "));
+    printTimelineCost(numLEDs, numEvents, elapsed);
+  }
+
+  // Write the per-frame time and cycles per pixel of a benchmark. Returns the cycles per pixel.
+  uint32_t printFrameCost(uint16_t numLEDs, uint32_t elapsed) {
+    uint32_t cycles = elapsed * (F_CPU / 1000000) / (static_cast<uint32_t>(numFrames) * numLEDs);
+
+    Serial.print(numLEDs);
+    Serial.print(F(", us/frame: "));
+    Serial.print(elapsed / numFrames);
+    Serial.print(F(", cycles/pixel: "));
+    Serial.print(cycles);
+    return cycles;
+  }
+
+  // Write the output stage cycles per pixel against its budget.
+  void printBudget(uint32_t cycles) {
+    Serial.print(F(", budget: "));
+    Serial.print(Output::cycleBudget);
+    Serial.println(cycles <= Output::cycleBudget ? F(" PASS") : F(" FAIL"));
+  }
+
+  // Per-frame cost of the output stage, converted in place as the cost is the same.
+  void benchOutput(uint16_t numLEDs) {
+    for (uint16_t i = 0; i < numLEDs; i++) {
+      pool.pixels[i] = CRGB(randomLFSR(), randomLFSR(), randomLFSR());
+    }
+    Output::Init(pool.pixels, pool.pixels, numLEDs);
+    uint32_t start = micros();
+    for (uint16_t f = 0; f < numFrames; f++) {
+      Output::update();
+    }
+    uint32_t elapsed = micros() - start;
+
+    Serial.print(F("Output stage, LEDs: "));
+    printBudget(printFrameCost(numLEDs, elapsed));
+  }
+
+  // Time to load each pallette into the active pallette cache.
+  void benchPalletteLoad() {
+    for (uint8_t i = 0; i < colours.getNumPallettes(); i++) {
+      uint32_t start = micros();
+      colours.setPallette(i);
+      uint32_t elapsed = micros() - start;
+
+      Serial.print(F("Pallette load, pallette: "));
+      Serial.print(i);
+      Serial.print(F(", colours: "));
+      Serial.print(colours.getPalletteSize());
+      Serial.print(F(", us: "));
+      Serial.println(elapsed);
+    }
+    Serial.print(F("Pallette store capacity: "));
+    Serial.print(Storage::getPalletteCapacity());
+    Serial.println(F(" bytes"));
+  }
+}
+
+namespace Benchmark {
+  //
+  // Run all benchmarks and print the results.
+  //
+  void run() {
+    const uint16_t sizes[] = { 2, 64, maxLEDs };
+
+    Serial.println(F("Benchmarks..."));
+    for (uint16_t numLEDs : sizes) {
+      benchScheduler(numLEDs);
+      benchScan(numLEDs);
+      benchOutput(numLEDs);
+    }
+    benchPalletteLoad();
+  }
+
+  //
+  // Print SRAM used per LED, against the v0.1 layout of CRGB leds[numLEDs] only.
+  //
+  void printMemory(uint16_t bytesPerLED) {
+    Serial.print(F("LED SRAM, v0.1 bytes/LED: "));
+    Serial.print(sizeof(CRGB));
+    Serial.print(F(", now bytes/LED: "));
+    Serial.print(bytesPerLED);
+    Serial.print(F(", increase bytes/LED: "));
+    Serial.println(bytesPerLED - sizeof(CRGB));
+  }
+}
+
+#endif
@@ -12,24 +12,78 @@
 //
 // Version History:
 // 0.1    2025-12-01    Initial version.
+// 0.2    2026-10-19    User defined pallettes, active pallette cache.
 //
 
 #include <stdint.h>
 #include <Arduino.h>
 #include "colours.h"
+#include "storage.h"
 
 namespace {
-  constexpr uint8_t numPallettes = 3;
+  // Pallette 0: White and primary colours.
+  constexpr uint8_t pallette0Size = 4;
+  const uint32_t pallette0[pallette0Size] PROGMEM = {
+    CRGB::White, CRGB::Red, CRGB::Green, CRGB::Blue
+  };
+
+  // Pallette 1: pallette 0 plus desaturated primary colours.
+  constexpr uint8_t pallette1Size = 7;
+  const uint32_t pallette1[pallette1Size] PROGMEM = {
+    CRGB::White, CRGB::Red, CRGB::Green, CRGB::Blue,
+    CRGB::Cyan, CRGB::Magenta, CRGB::Yellow
+  };
+
+  // Pallette 2: pallette 1 plus some others.
+  constexpr uint8_t pallette2Size = 16;
+  const uint32_t pallette2[pallette2Size] PROGMEM = {
+    CRGB::White, CRGB::Red, CRGB::Green, CRGB::Blue,
+    CRGB::Cyan, CRGB::Magenta, CRGB::Yellow,
+    CRGB::Pink, CRGB::LightGreen, CRGB::LightBlue,
+    CRGB::Maroon, CRGB::YellowGreen, CRGB::Navy,
+    CRGB::Orange, CRGB::Chocolate, CRGB::Indigo
+  };
+
+  const uint8_t palletteSizes[Colours::numBuiltInPallettes] = { pallette0Size, pallette1Size, pallette2Size };
+  const uint32_t* const pallettes[Colours::numBuiltInPallettes] = { pallette0, pallette1, pallette2 };
+}
+
+//
+// Number of pallettes, built-in plus user defined.
+//
+const uint8_t Colours::getNumPallettes() {
+  return numBuiltInPallettes + Storage::getNumPallettes();
+}
+
+//
+// Load the active pallette into the cache, so getting colours never reads flash or EEPROM.
+//
+void Colours::loadPallette() {
+  if (palletteNum_ < numBuiltInPallettes) {
+    cacheSize_ = palletteSizes[palletteNum_];
+    for (uint8_t i = 0; i < cacheSize_; i++) {
+      cache_[i] = CRGB(pgm_read_dword(&pallettes[palletteNum_][i]));
+    }
+  } else {
+    cacheSize_ = Storage::readPallette(palletteNum_ - numBuiltInPallettes, nullptr, cache_, maxPalletteSize);
+  }
+
+  // Guard against an empty or corrupt user pallette.
+  if (cacheSize_ == 0) {
+    cache_[0] = CRGB::Black;
+    cacheSize_ = 1;
+  }
 }
 
 //
 // Set the palette.
 //
 void Colours::setPallette(uint8_t palletteNum) {
-  palletteNum_ = (palletteNum < numPallettes) ? palletteNum : 0;
+  palletteNum_ = (palletteNum < getNumPallettes()) ? palletteNum : 0;
+  loadPallette();
   
   // Set colour to first if moving to a palette with fewer colours than current.
-  if (colourNum_ >= palletteSizes_[palletteNum_]) {
+  if (colourNum_ >= cacheSize_) {
     colourNum_ = 0;
   }
 }
@@ -38,7 +92,7 @@ void Colours::setPallette(uint8_t palletteNum) {
 // Move to next palette.
 //
 uint8_t Colours::nextPallette() {
-  uint8_t newPallette = (palletteNum_ + 1) % numPallettes;
+  uint8_t newPallette = (palletteNum_ + 1) % getNumPallettes();
   setPallette(newPallette);
 
   return newPallette;
@@ -48,7 +102,7 @@ uint8_t Colours::nextPallette() {
 // Set colour from the current palette.
 //
 void Colours::setColour(uint8_t colourNum) {
-  colourNum_ = (colourNum < palletteSizes_[palletteNum_]) ? colourNum : 0;
+  colourNum_ = (colourNum < cacheSize_) ? colourNum : 0;
 }
 
 //
@@ -56,7 +110,7 @@ void Colours::setColour(uint8_t colourNum) {
 //
 uint8_t Colours::incrementColour() {
   uint8_t tmp = ++colourNum_; // Use tmp to avoid compiler wanrning
-  colourNum_ = tmp % palletteSizes_[palletteNum_];
+  colourNum_ = tmp % cacheSize_;
   
   return colourNum_;
 }
@@ -66,7 +120,7 @@ uint8_t Colours::incrementColour() {
 //
 uint8_t Colours::decrementColour() {
   uint8_t tmp = --colourNum_; // Use tmp to avoid compiler wanrning
-  colourNum_ = tmp % palletteSizes_[palletteNum_];
+  colourNum_ = tmp % cacheSize_;
 
   return colourNum_;
 };
@@ -75,13 +129,27 @@ uint8_t Colours::decrementColour() {
 // Choose a new random colour from the current palette, but avoid existing colour.
 //
 CRGB Colours::randomColour() {
+  uint8_t newCol = randomColourNum(colourNum_);
+  previousColour_ = cache_[colourNum_];
+  colourNum_ = newCol;
+
+  return cache_[colourNum_];
+}
+
+//
+// Choose a random colour number from the current palette, other than the one given.
+// Does not change the current colour, so can be used for independent per-LED colours.
+//
+uint8_t Colours::randomColourNum(uint8_t excludeNum) {
   uint8_t newCol;
 
+  if (cacheSize_ < 2) {
+    return 0;
+  }
+
   do {
-    newCol = random(palletteSizes_[palletteNum_]);
-  } while (newCol == colourNum_);
-  previousColour_ = pallettes_[palletteNum_][colourNum_];
-  colourNum_ = newCol;
+    newCol = random(cacheSize_);
+  } while (newCol == excludeNum);
 
-  return pallettes_[palletteNum_][colourNum_];
+  return newCol;
 }
\ No newline at end of file
@@ -12,17 +12,21 @@
 //
 // Version History:
 // 0.1    2025-12-01    Initial version.
+// 0.2    2026-10-19    Twinkle mode, pallette upload over serial, output stage.
 //
 
 #include <Arduino.h>
 #include <Wire.h>
 #include <FastLED.h>
 #include <OneButton.h>
+#include "benchmark.h"
 #include "colours.h"
+#include "output.h"
 #include "pins.h"
+#include "scheduler.h"
 #include "storage.h"
 
-constexpr char firmwareVersion[] = "Lightbox Mk1 Firmware V0.1";
+constexpr char firmwareVersion[] = "Lightbox Mk1 Firmware V0.2";
 constexpr char firmwareLocation[] = "https://github.com/NickPGSmith/Lightbox-Mk1";
 constexpr uint8_t numLEDs                   = 2;
 constexpr uint16_t statusOnInterval         = 10;
@@ -33,6 +37,7 @@ constexpr uint16_t colourIntervalStepSmall  = 100;
 constexpr uint16_t colourIntervalStepLarge  = 1000;
 constexpr uint16_t fadeIntervalBoundary1    = 5000;
 constexpr uint16_t fadeIntervalBoundary2    = 10000;
+constexpr uint16_t fadeStepInterval         = 20;
 constexpr uint8_t fullBrightness            = 0xFF;
 constexpr uint8_t medBrightness             = 0x7F;
 constexpr uint8_t lowBrightness             = 0x1F;
@@ -40,6 +45,7 @@ constexpr uint8_t lowBrightness             = 0x1F;
 enum class Mode : uint8_t { Constant,
                             RandomPair, RandomPairFade,
                             RandomSingle, RandomSingleFade,
+                            Twinkle,
                             _END_ /* Sentinel */};
 
 //
@@ -49,7 +55,8 @@ enum class Mode : uint8_t { Constant,
 //
 namespace {
   Colours colours;
-  CRGB leds[numLEDs];
+  CRGB leds[numLEDs];              // Frame rendered by the modes
+  CRGB ledOutput[numLEDs];        // Frame after the output stage, sent to the LEDs
   Mode mode;
   OneButton but1, but2, but3;
   
@@ -60,6 +67,28 @@ namespace {
   bool status = false;            // State of onboard LED
   bool colourFade = false;        // True if in fade phase between colours
   bool singleState = false;       // In Single modes, true for second LED on
+
+  // Independent colour timeline for each LED, used in Twinkle mode.
+  // Holding a colour when fromColour == toColour, otherwise fading between them.
+  struct Timeline {
+    uint16_t fadeEnd;             // Low 16 bits of millis() when fade completes
+    uint16_t fadeInterval;        // Length of this LED's fade
+    uint8_t fromColour;           // Pallette colour number faded from
+    uint8_t toColour;             // Pallette colour number faded to
+  };
+  Timeline timelines[numLEDs];
+  Scheduler::Event ledEvents[numLEDs];
+  Scheduler scheduler(ledEvents, numLEDs);
+
+  // Serial command parser, one command per line.
+  char command = 0;                                     // Command letter of current line
+  char token[Storage::palletteNameLength + 1];          // Current token, truncated if longer
+  uint8_t tokenLength = 0;                              // Length of current token before truncation
+  uint8_t tokenNum = 0;                                 // Tokens completed on current line
+  char uploadName[Storage::palletteNameLength + 1];     // Name of pallette being uploaded
+  CRGB uploadColours[Colours::maxPalletteSize];         // Colours of pallette read so far
+  uint8_t uploadSize = 0;                               // Number of colours read so far
+  bool uploadError = false;                             // True if any colour was invalid
 };
 
 // 
@@ -71,6 +100,63 @@ namespace {
   // Ensure change is shown quickly by making the previous timer expire soon.
   void jumpTimer() {
     previousColourTimer = millis() - 10;
+    scheduler.clear();
+  }
+
+  // For longer intervals, use a larger fade interval.
+  uint16_t getFadeInterval(uint16_t interval) {
+    if (interval <= fadeIntervalBoundary1) {
+      return interval / 4;
+    } else if (interval <= fadeIntervalBoundary2) {
+      return interval / 2;
+    } else {
+      return interval;
+    }
+  }
+
+  // Random hold time for one LED, between 0.5 and 1.5 of the colour interval.
+  uint16_t randomHoldInterval() {
+    return colourInterval / 2 + random(colourInterval);
+  }
+
+  // Give every LED its own random colour and stagger their first changes.
+  void startTimelines(uint16_t now) {
+    scheduler.clear();
+    for (uint16_t i = 0; i < numLEDs; i++) {
+      uint8_t colour = random(colours.getPalletteSize());
+      timelines[i] = { now, 0, colour, colour };
+      leds[i] = colours.getColour(colour);
+      scheduler.schedule(i, now + random(colourInterval));
+    }
+  }
+
+  // Advance the timeline of one LED whose deadline has expired, and schedule its next event.
+  void updateTimeline(uint16_t led, uint16_t now) {
+    Timeline& t = timelines[led];
+
+    // End of hold: start fading to a new colour.
+    if (t.fromColour == t.toColour) {
+      uint16_t hold = randomHoldInterval();
+      t.toColour = colours.randomColourNum(t.fromColour);
+      t.fadeInterval = getFadeInterval(hold);
+      t.fadeEnd = now + t.fadeInterval;
+      scheduler.schedule(led, now + fadeStepInterval);
+      return;
+    }
+
+    // End of fade: hold the new colour.
+    uint16_t remaining = t.fadeEnd - now;
+    if (static_cast<int16_t>(remaining) <= 0) {
+      t.fromColour = t.toColour;
+      leds[led] = colours.getColour(t.toColour);
+      scheduler.schedule(led, now + randomHoldInterval());
+      return;
+    }
+
+    // Part way through fade.
+    uint8_t fadeFraction = 0xFF - static_cast<uint32_t>(remaining) * 0xFF / t.fadeInterval;
+    leds[led] = colours.getColour(t.fromColour).lerp8(colours.getColour(t.toColour), fadeFraction);
+    scheduler.schedule(led, now + fadeStepInterval);
   }
 
   // Write interval to serial.
@@ -98,6 +184,139 @@ namespace {
     Serial.println(static_cast<uint8_t>(pallette));
   }
 
+  // Write a colour to serial as RRGGBB.
+  void printColour(CRGB colour) {
+    for (uint8_t i = 0; i < 3; i++) {
+      if (colour.raw[i] < 0x10) {
+        Serial.print('0');
+      }
+      Serial.print(colour.raw[i], HEX);
+    }
+  }
+
+  // Write user defined pallette store usage to serial.
+  void printPalletteStore() {
+    Serial.print(F("Pallette store: "));
+    Serial.print(Storage::getPalletteUsed());
+    Serial.print(F(" / "));
+    Serial.print(Storage::getPalletteCapacity());
+    Serial.println(F(" bytes"));
+  }
+
+  // Write user defined pallettes to serial.
+  void listPallettes() {
+    char name[Storage::palletteNameLength + 1];
+    CRGB entries[Colours::maxPalletteSize];
+
+    for (uint8_t i = 0; i < Storage::getNumPallettes(); i++) {
+      uint8_t size = Storage::readPallette(i, name, entries, Colours::maxPalletteSize);
+      Serial.print(Colours::numBuiltInPallettes + i);
+      Serial.print(F(": "));
+      Serial.print(name);
+      for (uint8_t j = 0; j < size; j++) {
+        Serial.print(' ');
+        printColour(entries[j]);
+      }
+      Serial.println();
+    }
+    printPalletteStore();
+  }
+
+  // Convert a token of exactly six hex digits, RRGGBB, to a colour. Returns false if invalid.
+  bool parseColour(const char* token, uint8_t length, CRGB& colour) {
+    if (length != 6) {
+      return false;
+    }
+    for (uint8_t i = 0; i < 6; i++) {
+      if (!isxdigit(token[i])) {
+        return false;
+      }
+    }
+    colour = CRGB(strtoul(token, nullptr, 16));
+    return true;
+  }
+
+  // Process a completed token on the serial line.
+  void serialToken() {
+    token[min(tokenLength, Storage::palletteNameLength)] = 0;
+
+    if (tokenNum == 0) {
+      command = toupper(token[0]);
+    } else if (command == 'P' && tokenNum == 1) {
+      strcpy(uploadName, token);
+    } else if (command == 'P') {
+      if (uploadSize >= Colours::maxPalletteSize ||
+          !parseColour(token, tokenLength, uploadColours[uploadSize])) {
+        uploadError = true;
+      } else {
+        uploadSize++;
+      }
+    }
+    tokenNum++;
+    tokenLength = 0;
+  }
+
+  // Execute the command on a completed serial line.
+  void serialCommand() {
+    switch (command) {
+      case 0:
+        break;
+      case 'C':
+        Storage::clearPallettes();
+        if (colours.getPallette() >= Colours::numBuiltInPallettes) {
+          colours.setPallette(0);
+          Storage::setPallette(0);
+          scheduler.clear();
+          printPallette(0);
+        }
+        printPalletteStore();
+        break;
+      case 'L':
+        listPallettes();
+        break;
+      case 'P':
+        // Written once the line is complete, as each EEPROM write blocks for about 3.3 ms.
+        if (!uploadError && Storage::writePallette(uploadName, uploadColours, uploadSize)) {
+          Serial.print(F("Pallette added: "));
+          Serial.println(colours.getNumPallettes() - 1);
+        } else {
+          Serial.println(F("Pallette upload failed."));
+        }
+        printPalletteStore();
+        break;
+      default:
+        Serial.println(F("Commands: L (list), C (clear), P <name> <RRGGBB> <RRGGBB> ..."));
+    }
+
+    command = 0;
+    tokenNum = 0;
+    uploadName[0] = 0;
+    uploadSize = 0;
+    uploadError = false;
+  }
+
+  // Read serial commands, without blocking.
+  void serialInput() {
+    while (Serial.available()) {
+      char c = Serial.read();
+      if (c == ' ' || c == '\r' || c == '\n') {
+        if (tokenLength > 0) {
+          serialToken();
+        }
+        if (c != ' ') {
+          serialCommand();
+        }
+      } else {
+        if (tokenLength < Storage::palletteNameLength) {
+          token[tokenLength] = c;
+        }
+        if (tokenLength < 0xFF) {
+          tokenLength++;
+        }
+      }
+    }
+  }
+
   // Cycle through modes.
   void but1Click() {
     uint8_t modeNum = (static_cast<uint8_t>(mode) + 1) % static_cast<uint8_t>(Mode::_END_);
@@ -109,7 +328,7 @@ namespace {
 
   // Toggle brightness low/medium/full.
   void but1DoubleClick() {
-    uint8_t brightness = Storage::getBrightness();
+    uint8_t brightness = Output::getBrightness();
     switch (brightness) {
       case (fullBrightness):
         brightness = lowBrightness;
@@ -120,16 +339,22 @@ namespace {
       default:
         brightness = fullBrightness;
     }
-    FastLED.setBrightness(brightness);
+    Output::setBrightness(brightness);
     Storage::setBrightness(brightness);
     printBrightness(brightness);
   }
   
   // Cycle through pallettes.
   void but1LongPress() {
+    uint32_t loadTimer = micros();
     uint8_t pallette = colours.nextPallette();
+    loadTimer = micros() - loadTimer;
+    scheduler.clear();
     Storage::setPallette(pallette);
     printPallette(pallette);
+    Serial.print(F("Pallette load: "));
+    Serial.print(loadTimer);
+    Serial.println(F(" us"));
   }
   
   // Decrement colour or interval.
@@ -258,16 +483,23 @@ void setup() {
     Serial.println(F("Loading defaults... "));
   }
 
+#ifdef LIGHTBOX_BENCHMARK
+  Benchmark::run();
+  Benchmark::printMemory(sizeof(leds[0]) + sizeof(ledOutput[0]) + sizeof(timelines[0]) + sizeof(ledEvents[0]));
+#endif
+
   // Setup LEDs and settings from EEPROM.
   pinMode(LED_BUILTIN, OUTPUT);
-  FastLED.addLeds<WS2812, Pins::LED_Data, GRB>(leds, numLEDs);
+  FastLED.addLeds<WS2812, Pins::LED_Data, GRB>(ledOutput, numLEDs);
   FastLED.setMaxPowerInVoltsAndMilliamps(5, 450); // For 500 mA USB PSU
+  Output::Init(leds, ledOutput, numLEDs);
   uint8_t tmp = Storage::getBrightness();
-  FastLED.setBrightness(tmp);
+  Output::setBrightness(tmp);
   printBrightness(tmp);
   tmp = Storage::getPallette();
   colours.setPallette(tmp);
   printPallette(tmp); 
+  printPalletteStore();
   tmp = Storage::getColour();
   colours.setColour(tmp);
   Serial.print(F("Colour: "));
@@ -305,11 +537,28 @@ void loop() {
   but2.tick();
   but3.tick();
 
+  // Pallette upload and other serial commands.
+  serialInput();
+
   // Constant colour on both LEDs regardless of the timer.
   if (mode == Mode::Constant) {
     leds[0] = colours.getColour();
     leds[1] = colours.getColour();
-    FastLED.show();
+    Output::show();
+    return;
+  }
+
+  // Independent timeline per LED: only update those LEDs whose deadlines have expired.
+  // Show every loop regardless, to advance the output dither.
+  if (mode == Mode::Twinkle) {
+    uint16_t now = currentTimer;
+    if (scheduler.empty()) {
+      startTimelines(now);
+    }
+    while (scheduler.due(now)) {
+      updateTimeline(scheduler.pop(), now);
+    }
+    Output::show();
     return;
   }
 
@@ -327,7 +576,7 @@ void loop() {
       leds[0] = colours.getColour();
       leds[1] = colours.getColour();
     }
-    FastLED.show();
+    Output::show();
     return;
   }
 
@@ -341,15 +590,7 @@ void loop() {
     return;
   }
 
-  // For longer intervals, use a larger fade interval.
-  uint16_t fadeInterval = 0;
-  if (colourInterval <= fadeIntervalBoundary1) {
-    fadeInterval = colourInterval / 4;
-  } else if (colourInterval <= fadeIntervalBoundary2) {
-    fadeInterval = colourInterval / 2;
-  } else {
-    fadeInterval = colourInterval;
-  }
+  uint16_t fadeInterval = getFadeInterval(colourInterval);
 
   // Time to start colour fade.
   if (deltaTimer < (colourInterval + fadeInterval)) {
@@ -372,7 +613,7 @@ void loop() {
       leds[0] = fadeColour;
       leds[1] = fadeColour;
     }
-    FastLED.show();
+    Output::show();
     return;
   }
 
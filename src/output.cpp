@@ -0,0 +1,127 @@
+//
+// Name: output.cpp
+// Purpose: Output stage: gamma, white balance, brightness and temporal dithering.
+//
+// This program is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2.1 of the License, or any later version.
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+// Do not remove information from this header.
+//
+// Version History:
+// 0.2    2026-10-19    Initial version.
+//
+
+#include <stdint.h>
+#include <Arduino.h>
+#include <FastLED.h>
+#include "output.h"
+
+namespace {
+  // White balance for WS2812 (as FastLED TypicalLEDStrip), applied to each channel table.
+  constexpr uint8_t redCorrection   = 0xFF;
+  constexpr uint8_t greenCorrection = 0xB0;
+  constexpr uint8_t blueCorrection  = 0xF0;
+
+  // Fifth root by Newton's method, as gamma 2.2 = x^2 * x^(1/5).
+  constexpr float root5(float x, float r = 1.0, uint8_t n = 32) {
+    return (n == 0 || r <= 0) ? r : root5(x, r - (r * r * r * r * r - x) / (5 * r * r * r * r), n - 1);
+  }
+
+  // Table entry: 8-bit colour value to 16-bit linear output, with gamma and white balance.
+  constexpr uint16_t gammaEntry(uint8_t value, uint8_t correction) {
+    return static_cast<uint16_t>((value / 255.0f) * (value / 255.0f) * root5(value / 255.0f) *
+                                 (0xFFFF * (correction / 255.0f)) + 0.5f);
+  }
+
+  static_assert(gammaEntry(0, 0xFF) == 0, "Gamma table must start at 0");
+  static_assert(gammaEntry(0xFF, 0xFF) == 0xFFFF, "Gamma table must end at full scale");
+
+  // Build a table of every 8-bit value at compile time, stored in flash.
+  template<uint16_t... I> struct Sequence {};
+  template<uint16_t N, uint16_t... I> struct MakeSequence : MakeSequence<N - 1, N - 1, I...> {};
+  template<uint16_t... I> struct MakeSequence<0, I...> { typedef Sequence<I...> Type; };
+
+  template<uint8_t Correction, typename S> struct GammaTable;
+  template<uint8_t Correction, uint16_t... I> struct GammaTable<Correction, Sequence<I...>> {
+    static const uint16_t values[sizeof...(I)];
+  };
+  template<uint8_t Correction, uint16_t... I>
+  const uint16_t GammaTable<Correction, Sequence<I...>>::values[sizeof...(I)] PROGMEM = {
+    gammaEntry(I, Correction)...
+  };
+
+  typedef MakeSequence<256>::Type Levels;
+  const uint16_t* const tables[3] = {
+    GammaTable<redCorrection, Levels>::values,
+    GammaTable<greenCorrection, Levels>::values,
+    GammaTable<blueCorrection, Levels>::values
+  };
+
+  // Ordered dither thresholds for the top 3 bits of the remainder, cycled on each show().
+  constexpr uint8_t numDitherPhases = 8;
+  const uint8_t ditherThresholds[numDitherPhases] = { 0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0 };
+  constexpr uint8_t ditherPixelStep = 3;    // Phase offset between neighbouring pixels
+
+  const CRGB* frame_ = nullptr;
+  CRGB* leds_ = nullptr;
+  uint16_t numLEDs_ = 0;
+  uint8_t brightness_ = 0xFF;
+  uint8_t ditherPhase_ = 0;
+}
+
+namespace Output {
+  //
+  // Set the rendered frame and the output buffer given to FastLED.
+  //
+  void Init(const CRGB* frame, CRGB* leds, uint16_t numLEDs) {
+    frame_ = frame;
+    leds_ = leds;
+    numLEDs_ = numLEDs;
+    FastLED.setBrightness(0xFF);
+    FastLED.setDither(DISABLE_DITHER);
+  }
+
+  //
+  // Get/Set the brightness.
+  //
+  const uint8_t getBrightness() {
+    return brightness_;
+  }
+
+  void setBrightness(uint8_t value) {
+    brightness_ = value;
+  }
+
+  //
+  // Convert the frame to the output buffer. Same work for every pixel, whatever its colour.
+  // Globals are copied to locals, as byte stores to leds would otherwise force them to be
+  // reloaded for every channel.
+  //
+  void update() {
+    const uint8_t* frame = frame_->raw;
+    uint8_t* leds = leds_->raw;
+    const uint8_t brightness = brightness_;
+    uint8_t phase = ditherPhase_;
+
+    for (uint16_t i = numLEDs_; i > 0; i--) {
+      uint8_t threshold = ditherThresholds[phase];
+      for (uint8_t c = 0; c < 3; c++) {
+        uint16_t value = scale16by8(pgm_read_word(&tables[c][*frame++]), brightness);
+        *leds++ = qadd8(value >> 8, static_cast<uint8_t>(value) > threshold);
+      }
+      phase = (phase + ditherPixelStep) % numDitherPhases;
+    }
+    ditherPhase_ = (ditherPhase_ + 1) % numDitherPhases;
+  }
+
+  //
+  // Convert and show the frame. Call as often as possible, as each call advances the dither.
+  //
+  void show() {
+    update();
+    FastLED.show();
+  }
+}
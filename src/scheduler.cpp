@@ -0,0 +1,75 @@
+//
+// Name: scheduler.cpp
+// Purpose: Min-heap of per-LED deadlines, so only LEDs whose timers expire are updated.
+//
+// This program is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2.1 of the License, or any later version.
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+// Do not remove information from this header.
+//
+// Version History:
+// 0.2    2026-10-19    Initial version.
+//
+
+#include <stdint.h>
+#include "scheduler.h"
+
+//
+// Add an event, sifting it up to its place in the heap. Returns false if full.
+//
+bool Scheduler::schedule(uint16_t id, uint16_t deadline) {
+  if (size_ >= capacity_) {
+    return false;
+  }
+
+  uint16_t i = size_++;
+  while (i > 0) {
+    uint16_t parent = (i - 1) / 2;
+    if (!before(deadline, events_[parent].deadline)) {
+      break;
+    }
+    events_[i] = events_[parent];
+    i = parent;
+  }
+  events_[i] = { deadline, id };
+
+  return true;
+}
+
+//
+// True if the earliest event has reached its deadline.
+//
+bool Scheduler::due(uint16_t now) {
+  return size_ > 0 && !before(now, events_[0].deadline);
+}
+
+//
+// Remove the earliest event and return its id. Only call when not empty.
+//
+uint16_t Scheduler::pop() {
+  uint16_t id = events_[0].id;
+  Event last = events_[--size_];
+
+  // Sift the last event down from the root.
+  uint16_t i = 0;
+  while (true) {
+    uint16_t child = 2 * i + 1;
+    if (child >= size_) {
+      break;
+    }
+    if (child + 1 < size_ && before(events_[child + 1].deadline, events_[child].deadline)) {
+      child++;
+    }
+    if (!before(events_[child].deadline, last.deadline)) {
+      break;
+    }
+    events_[i] = events_[child];
+    i = child;
+  }
+  events_[i] = last;
+
+  return id;
+}
@@ -12,6 +12,7 @@
 //
 // Version History:
 // 0.1    2025-12-01    Initial version.
+// 0.2    2026-10-19    User defined pallette store.
 //
 
 #include <Arduino.h>
@@ -35,6 +36,24 @@ namespace Storage {
   constexpr uint16_t addrInterval = addrColour + sizeof(uint8_t);
   constexpr uint16_t addrMode = addrInterval + sizeof(uint16_t);
   constexpr uint16_t addrPallette = addrMode + sizeof(uint8_t);
+  constexpr uint16_t addrNumPallettes = addrPallette + sizeof(uint8_t);
+  constexpr uint16_t addrPalletteStore = addrNumPallettes + sizeof(uint8_t);
+
+  // Size of each part of a user defined pallette record.
+  constexpr uint8_t palletteHeaderSize = sizeof(uint8_t) + palletteNameLength;
+  constexpr uint8_t palletteColourSize = 3;
+
+  //
+  // Address of a user defined pallette record, or the free space if index is the number stored.
+  //
+  uint16_t palletteAddr(uint8_t index) {
+    uint16_t addr = addrPalletteStore;
+
+    for (uint8_t i = 0; i < index; i++) {
+      addr += palletteHeaderSize + EEPROM.read(addr) * palletteColourSize;
+    }
+    return addr;
+  }
 
   //
   // Check whether EEPROM has been initialised (new EEPROM contains all 0xFF).
@@ -54,6 +73,7 @@ namespace Storage {
     setInterval(defaultInterval);
     setMode(defaultMode);
     setPallette(defaultPallette);
+    clearPallettes();
   }
 
   //
@@ -125,4 +145,87 @@ namespace Storage {
   void setPallette(uint8_t value) {
     EEPROM.put(addrPallette, value);
   }
+
+  //
+  // Get the number of user defined pallettes (new EEPROM contains 0xFF).
+  //
+  const uint8_t getNumPallettes() {
+    uint8_t value = EEPROM.read(addrNumPallettes);
+
+    return (value > maxPallettes) ? 0 : value;
+  }
+
+  //
+  // Get the total and used bytes for user defined pallettes.
+  //
+  const uint16_t getPalletteCapacity() {
+    return EEPROM.length() - addrPalletteStore;
+  }
+
+  const uint16_t getPalletteUsed() {
+    return palletteAddr(getNumPallettes()) - addrPalletteStore;
+  }
+
+  //
+  // Read a user defined pallette. The name (if not null) must hold palletteNameLength + 1
+  // characters. Returns the number of colours read, 0 if the pallette does not exist.
+  //
+  uint8_t readPallette(uint8_t index, char* name, CRGB* colours, uint8_t maxColours) {
+    if (index >= getNumPallettes()) {
+      return 0;
+    }
+
+    uint16_t addr = palletteAddr(index);
+    uint8_t size = EEPROM.read(addr);
+    if (size > maxColours) {
+      size = maxColours;
+    }
+    if (name) {
+      for (uint8_t i = 0; i < palletteNameLength; i++) {
+        name[i] = EEPROM.read(addr + sizeof(uint8_t) + i);
+      }
+      name[palletteNameLength] = 0;
+    }
+    addr += palletteHeaderSize;
+    for (uint8_t i = 0; i < size; i++) {
+      colours[i].r = EEPROM.read(addr++);
+      colours[i].g = EEPROM.read(addr++);
+      colours[i].b = EEPROM.read(addr++);
+    }
+    return size;
+  }
+
+  //
+  // Add a pallette after the last stored one. Returns false if no room.
+  //
+  bool writePallette(const char* name, const CRGB* colours, uint8_t size) {
+    uint8_t numPallettes = getNumPallettes();
+    uint16_t addr = palletteAddr(numPallettes);
+
+    if (size == 0 || numPallettes >= maxPallettes ||
+        addr + palletteHeaderSize + size * palletteColourSize > EEPROM.length()) {
+      return false;
+    }
+    EEPROM.update(addr, size);
+    bool nameEnd = false;
+    for (uint8_t i = 0; i < palletteNameLength; i++) {
+      nameEnd = nameEnd || name[i] == 0;
+      EEPROM.update(addr + sizeof(uint8_t) + i, nameEnd ? 0 : name[i]);
+    }
+    addr += palletteHeaderSize;
+    for (uint8_t i = 0; i < size; i++) {
+      EEPROM.update(addr++, colours[i].r);
+      EEPROM.update(addr++, colours[i].g);
+      EEPROM.update(addr++, colours[i].b);
+    }
+    EEPROM.update(addrNumPallettes, numPallettes + 1);
+    return true;
+  }
+
+  //
+  // Remove all user defined pallettes.
+  //
+  void clearPallettes() {
+    EEPROM.update(addrNumPallettes, 0);
+  }
 }
\ No newline at end of file